@@ -75,7 +75,7 @@ class EspDebug : public Stream {
 #else
     static const uint16_t m_bufferSize = 64;
 #endif
-    byte m_buffer[m_bufferSize+1];
+    byte m_buffer[m_bufferSize];
     uint16_t m_inPos = 0, m_SerialOut = 0;
     boolean m_bufferedWrite = true;
     boolean m_setupLog = true;
@@ -86,7 +86,8 @@ class EspDebug : public Stream {
 
     WiFiServer m_DbgServer = NULL;
     WiFiClient m_DbgClient;
-    String m_SetupLogData = "";
+    byte m_SetupLogData[m_bufferSize];
+    uint16_t m_SetupLogSize = 0;
 #endif
 };
 
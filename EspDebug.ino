@@ -128,11 +128,11 @@ void EspDebug::loop() {
       m_DbgClient.setNoDelay(true);
 
       // force send
-      if (m_SetupLogData != "") {
-          m_DbgClient.write(m_SetupLogData.c_str(), m_SetupLogData.length());
-          if (m_SetupLogData.length() == m_bufferSize)
+      if (m_SetupLogSize > 0) {
+          m_DbgClient.write(&m_SetupLogData[0], m_SetupLogSize);
+          if (m_SetupLogSize == m_bufferSize)
             m_DbgClient.write("\n...\n\n");
-          m_SetupLogData = "";
+          m_SetupLogSize = 0;
       }
     }
   }
@@ -172,8 +172,8 @@ void EspDebug::sendBuffer() {
 #ifdef DBG_PRINTER_NET
   if (dbgClientClosed()) {
     if (m_setupLog && m_inPos == m_bufferSize) {
-      m_buffer[m_inPos] = 0;
-      m_SetupLogData = String((char*)m_buffer);
+      memcpy(&m_SetupLogData[0], &m_buffer[0], m_inPos);
+      m_SetupLogSize = m_inPos;
       m_setupLog = false;
     }
     if (!m_setupLog)
@@ -31,10 +31,27 @@
 #include "EspWifi.h"
 #include "HelperHTML.h"
 
+#include <StreamString.h>
+
 #define PROGNAME "EspSerialBridge"
 #define PROGVERS "0.3"
 #define PROGBUILD String(__DATE__) + " " + String(__TIME__)
 
+#ifdef _DEBUG_HEAP
+  // subsystems called from loop(), used to attribute heap drops and track the free heap watermark (see EspTools)
+  enum heapSubsystem : uint8_t {
+    heapSubsystemWiFi           = 0
+  , heapSubsystemTools          = 1
+  , heapSubsystemSerialBridge   = 2
+  , heapSubsystemDebug          = 3
+  , heapSubsystemCount          = 4
+  };
+
+  #define HEAP_PROBE(subsystem, call) { heapProbeBegin(); call; heapProbeEnd(subsystem); }
+#else
+  #define HEAP_PROBE(subsystem, call) { call; }
+#endif
+
 bool httpRequestProcessed     = false;
 bool optionsChanged           = false;
 
@@ -73,6 +90,7 @@ class EspSerialBridgeRequestHandler : public EspWiFiRequestHandler {
     String menuIdentifiers(uint8_t identifier) override;
     String menuIdentifierSerial() { return "serial"; };
     String menuIdentifierOtaAddon() { return "ota-addon"; };
+    String menuIdentifierProbe() { return "probe"; };
         
     String getDevicesUri() { return "/devices"; };
     String getOtaAtMegaUri() { return "/ota/atmega328.bin"; };
@@ -121,15 +139,15 @@ void setup() {
 
 void loop(void) {
   // handle wifi
-  espWiFi.loop();
+  HEAP_PROBE(heapSubsystemWiFi, espWiFi.loop());
 
   // tools
-  loopEspTools();
+  HEAP_PROBE(heapSubsystemTools, loopEspTools());
 
-  espSerialBridge.loop();
+  HEAP_PROBE(heapSubsystemSerialBridge, espSerialBridge.loop());
 
   // send debug data
-  espDebug.loop();
+  HEAP_PROBE(heapSubsystemDebug, espDebug.loop());
 }
 
 // required EspWifi
@@ -140,7 +158,7 @@ String getDictionary() {
 // other
 void printHeapFree() {
 #ifdef _DEBUG_HEAP
-  DBG_PRINTLN((String)F("heap: ") + (String)(ESP.getFreeHeap()));
+  DBG_PRINTF("heap: free %lu max block %lu frag %u%%\n", (unsigned long)ESP.getFreeHeap(), (unsigned long)heapMaxFreeBlock(), heapFragmentation());
 #endif
 }
 
@@ -159,6 +177,20 @@ void handleInput(char r, bool hasValue, unsigned long value, bool hasValue2, uns
       ESP.reset();
       break;
 #endif
+#ifdef _DEBUG_HEAP
+    case 'h':
+      printHeapStats(espDebug);
+      break;
+#endif
+    case 'l':
+      // latency probe: 1=serial loopback, 2=client echo, 3=internal [,count]; without value print results
+      if (hasValue && (value < EspSerialBridge::probeModeSerial || value > EspSerialBridge::probeModeInternal)) {
+        DBG_PRINTLN("probe: unknown mode");
+      } else if (hasValue && !espSerialBridge.startProbe((EspSerialBridge::probeMode)value, (hasValue2 ? constrain(value2, 0UL, (unsigned long)EspSerialBridge::probeSamplesMax) : 0))) {
+        DBG_PRINTLN("probe: start failed");
+      }
+      espSerialBridge.printProbe(espDebug);
+      break;
     case 'u':
       DBG_PRINTLN("uptime: " + uptime());
       printHeapFree();
@@ -203,7 +235,7 @@ void handleInputStream(Stream *input) {
           }
           
           hasValue2 = true;
-          if (sign == 0) {
+          if (sign == 1) {
             value = value * -1;
             sign = 0;
           }
@@ -286,6 +318,28 @@ bool EspSerialBridgeRequestHandler::handle(ESP8266WebServer& server, HTTPMethod
 bool EspSerialBridgeRequestHandler::handle(WebServer& server, HTTPMethod method, String uri) {
 #endif
 
+  // latency probe: mode=1 (serial loopback), 2 (client echo), 3 (internal) starts, otherwise report results
+  if (method == HTTP_POST && uri == getConfigUri() && server.arg(menuIdentifierSerial()) == menuIdentifierProbe()) {
+    uint16_t resultCode = 200;
+    if (server.hasArg("mode")) {
+      long mode = server.arg("mode").toInt();
+      long count = constrain(server.arg("count").toInt(), 0L, (long)EspSerialBridge::probeSamplesMax);
+
+      if (mode < EspSerialBridge::probeModeSerial || mode > EspSerialBridge::probeModeInternal)
+        resultCode = 400;
+      else if (!espSerialBridge.startProbe((EspSerialBridge::probeMode)mode, count))
+        resultCode = 409;
+    }
+
+    StreamString result;
+    espSerialBridge.printProbe(result);
+
+    server.client().setNoDelay(true);
+    server.send(resultCode, "text/plain", result);
+
+    return (httpRequestProcessed = true);
+  }
+
   if (method == HTTP_POST && uri == getConfigUri() && server.hasArg(menuIdentifierSerial())) {
     uint16_t resultCode;
     String html = handleDeviceConfig(server, &resultCode);
@@ -340,7 +394,7 @@ bool EspSerialBridgeRequestHandler::canHandle(WebServer& server) {
     return true;
 
   if (server.method() == HTTP_POST && server.uri() == getConfigUri()) {
-    if (server.hasArg(menuIdentifierSerial()) && (server.arg(menuIdentifierSerial()) == "" || server.arg(menuIdentifierSerial()) == "config"))
+    if (server.hasArg(menuIdentifierSerial()) && (server.arg(menuIdentifierSerial()) == "" || server.arg(menuIdentifierSerial()) == "config" || server.arg(menuIdentifierSerial()) == menuIdentifierProbe()))
       return true;
     if (server.hasArg(menuIdentifierOtaAddon()) && server.arg(menuIdentifierOtaAddon()) == "")
       return true;
@@ -40,8 +40,30 @@ class EspSerialBridge {
 
     void printDiag(Print& dest);
 
+    // latency probe (timestamped frames echoed back through one segment):
+    // round-trip time one frame at a time, then throughput of a back-to-back burst
+    enum probeMode : byte {
+      probeModeNone                       = 0x00
+    , probeModeSerial                     = 0x01  // TX-RX loopback jumper
+    , probeModeClient                     = 0x02  // tcp client echoes frames
+    , probeModeInternal                   = 0x03  // loop only, bypassing uart
+    };
+
+    static const uint16_t probeSamplesMax = 64;
+
+    bool startProbe(probeMode mode, uint16_t count=0);
+    void stopProbe();
+    bool isProbeRunning() { return m_probe.mode != probeModeNone; };
+    void printProbe(Print& dest);
+
   protected:
     int available();
+    void probeLoop();
+    void probeCollect();
+    bool probeCanSend();
+    void probeSend(uint16_t seq);
+    void probeReceive(byte data);
+    void probeFinish();
 
   private:
     static const unsigned int m_bufferSize=256;
@@ -59,6 +81,50 @@ class EspSerialBridge {
     SerialConfig m_SerialConfig = SERIAL_8N1;
     uint16_t m_tcpPort;
 
+    static const uint8_t m_probeFrameSize = 8;      // marker (2), sequence (2), timestamp (4)
+    static const uint8_t m_probeBurstFrames = 32;   // fills m_buffer in internal mode
+    static const unsigned long m_probeTimeout = 1000; // ms
+
+    enum probePhase : byte {
+      probePhaseLatency                   = 0x00  // one frame in flight
+    , probePhaseBurst                     = 0x01  // all frames in flight
+    , probePhaseDrain                     = 0x02  // results stored, dropping late echoes
+    };
+
+    struct ProbeSession {
+      probeMode     mode;
+      probePhase    phase;
+      uint16_t      count;
+      uint16_t      seq;        // latency: frame in flight, burst: next expected echo
+      uint16_t      received;
+      uint16_t      lost;
+      bool          pending;
+      uint16_t      burstSent;
+      uint16_t      burstReceived;
+      unsigned long sentAt;     // ms, last progress (timeout, drain)
+      unsigned long burstStart; // us
+      unsigned long burstEnd;   // us, last echo
+      byte          rx[m_probeFrameSize];
+      uint8_t       rxPos;
+      uint32_t      rtt[probeSamplesMax];  // us
+    };
+
+    // summary per segment (index mode - 1)
+    struct ProbeResult {
+      bool          valid;
+      uint16_t      samples;
+      uint16_t      lost;
+      uint32_t      min;        // us
+      uint32_t      median;     // us
+      uint32_t      p99;        // us
+      uint16_t      burstSent;
+      uint16_t      burstReceived;
+      uint32_t      throughput; // echoed bytes/s
+    };
+
+    ProbeSession m_probe = { probeModeNone };
+    ProbeResult m_probeResults[probeModeInternal] = { };
+
 #ifdef _ESPSERIALBRIDGE_TELNET_SUPPORT
 
     enum telnetCharacter : byte { // RFC854
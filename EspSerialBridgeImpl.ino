@@ -71,6 +71,12 @@ void EspSerialBridge::loop() {
     }
   }
 
+  // latency probe replaces bridging while running
+  if (m_probe.mode != probeModeNone) {
+    probeLoop();
+    return;
+  }
+
   // copy serial input to buffer
   while (Serial.available() && (m_inPos + 1 < m_bufferSize)) {
     int data = Serial.read();
@@ -94,10 +100,11 @@ void EspSerialBridge::loop() {
       int socketSend = m_WifiClient.write(&m_buffer[0], dataSend);
 
 #ifdef _DEBUG_TRAFFIC
-      String msg = "send: " + String(dataSend) + " bytes";
+      // no String here, loop() has to stay allocation free
+      DBG_PRINTF("send: %d bytes", dataSend);
       for (int i=0; i<dataSend; i++)
-        msg += " " + String(m_buffer[i], HEX);
-      espDebug.println(msg);
+        DBG_PRINTF(" %x", m_buffer[i]);
+      DBG_PRINTLN();
 #endif
       // move buffer
       if (socketSend < dataSend) {
@@ -130,10 +137,10 @@ void EspSerialBridge::loop() {
         Serial.write((data[i] & 0xff));
 
 #ifdef _DEBUG_TRAFFIC
-    String msg = "recv: " + String(dataRead) + " bytes";
+    DBG_PRINTF("recv: %d bytes", dataRead);
     for (int i=0; i<dataRead; i++)
-      msg += " " + String((byte)(data[i] & 0xff), HEX);
-    espDebug.println(msg);
+      DBG_PRINTF(" %x", (byte)(data[i] & 0xff));
+    DBG_PRINTLN();
 #endif
   }
 }
@@ -156,6 +163,9 @@ void EspSerialBridge::enableClientConnect(bool enable) {
     
   m_enableClient = enable;
 
+  if (!enable)
+    stopProbe();
+
   if (!enable && m_WifiClient.status() != CLOSED) {
     // send buffered data
     loop();
@@ -213,6 +223,280 @@ void EspSerialBridge::printDiag(Print& dest) {
   }
 }
 
+bool EspSerialBridge::startProbe(probeMode mode, uint16_t count) {
+  if (mode < probeModeSerial || mode > probeModeInternal || !m_enableClient || isProbeRunning())
+    return false;
+
+  // client has to echo frames
+  if (mode == probeModeClient && m_WifiClient.status() == CLOSED)
+    return false;
+
+  // drop pending data
+  if (mode == probeModeSerial)
+    while (Serial.available() > 0 && Serial.read() >= 0)
+      ;
+  m_inPos = 0;
+
+  m_probe.mode = mode;
+  m_probe.phase = probePhaseLatency;
+  m_probe.count = (count == 0 || count > probeSamplesMax ? probeSamplesMax : count);
+  m_probe.seq = m_probe.received = m_probe.lost = 0;
+  m_probe.pending = false;
+  m_probe.burstSent = m_probe.burstReceived = 0;
+  m_probe.rxPos = 0;
+  m_probe.sentAt = millis();
+  m_probe.burstStart = m_probe.burstEnd = micros();
+
+  return true;
+}
+
+void EspSerialBridge::stopProbe() {
+  if (m_probe.mode == probeModeNone)
+    return;
+
+  if (m_probe.phase != probePhaseDrain)
+    probeFinish();
+
+  // discard what already arrived, no grace period
+  probeCollect();
+  m_probe.mode = probeModeNone;
+}
+
+void EspSerialBridge::probeLoop() {
+  // client gone, nothing left to measure or drain
+  if (m_probe.mode == probeModeClient && m_WifiClient.status() == CLOSED) {
+    stopProbe();
+    return;
+  }
+
+  probeCollect();
+
+  // late echoes must not reach the bridge, drop them until the segment is quiet
+  if (m_probe.phase == probePhaseDrain) {
+    if (millis() - m_probe.sentAt >= m_probeTimeout)
+      m_probe.mode = probeModeNone;
+    return;
+  }
+
+  if (m_probe.phase == probePhaseLatency) {
+    // timed out, continue with next frame
+    if (m_probe.pending && millis() - m_probe.sentAt >= m_probeTimeout) {
+      m_probe.lost++;
+      m_probe.seq++;
+      m_probe.pending = false;
+      m_probe.rxPos = 0;
+      m_probe.sentAt = millis();
+    }
+
+    if (m_probe.pending)
+      return;
+
+    if (m_probe.seq < m_probe.count) {
+      if (probeCanSend()) {
+        probeSend(m_probe.seq);
+        m_probe.pending = true;
+      } else if (millis() - m_probe.sentAt >= m_probeTimeout) {
+        // segment takes no data, remaining frames are lost
+        m_probe.lost += m_probe.count - m_probe.seq;
+        m_probe.seq = m_probe.count;
+        probeFinish();
+      }
+      return;
+    }
+
+    // latency done, start burst
+    m_probe.phase = probePhaseBurst;
+    m_probe.seq = 0;
+    m_probe.rxPos = 0;
+    m_probe.sentAt = millis();
+    m_probe.burstStart = m_probe.burstEnd = micros();
+  }
+
+  // burst: send back-to-back as long as the segment takes it
+  while (m_probe.burstSent < m_probeBurstFrames && probeCanSend())
+    probeSend(m_probe.burstSent++);
+
+  if (m_probe.burstReceived >= m_probeBurstFrames || millis() - m_probe.sentAt >= m_probeTimeout)
+    probeFinish();
+}
+
+void EspSerialBridge::probeCollect() {
+  // echoed frames of the segment under test
+  switch (m_probe.mode) {
+    case probeModeSerial:
+      while (Serial.available() > 0) {
+        int data = Serial.read();
+        if (data < 0)
+          break;
+        probeReceive(data);
+      }
+      break;
+    case probeModeClient:
+      while (m_WifiClient.available() > 0) {
+        int data = m_WifiClient.read();
+        if (data < 0)
+          break;
+        probeReceive(data);
+      }
+      break;
+    case probeModeInternal:
+      // frames were left in buffer by the previous loop
+      for (uint16_t i=0; i<m_inPos; i++)
+        probeReceive(m_buffer[i]);
+      m_inPos = 0;
+      break;
+    default:
+      break;
+  }
+}
+
+bool EspSerialBridge::probeCanSend() {
+  switch (m_probe.mode) {
+    case probeModeSerial:
+      return Serial.availableForWrite() >= m_probeFrameSize;
+    case probeModeClient:
+      return m_WifiClient.availableForWrite() >= m_probeFrameSize;
+    case probeModeInternal:
+      return (unsigned int)(m_inPos + m_probeFrameSize) <= m_bufferSize;
+    default:
+      return false;
+  }
+}
+
+void EspSerialBridge::probeSend(uint16_t seq) {
+  unsigned long now = micros();
+  byte frame[m_probeFrameSize] = { 0xA5, (byte)(0x5A + m_probe.phase), (byte)(seq >> 8), (byte)seq
+    , (byte)(now >> 24), (byte)(now >> 16), (byte)(now >> 8), (byte)now };
+
+  switch (m_probe.mode) {
+    case probeModeSerial:
+      Serial.write(frame, sizeof(frame));
+      break;
+    case probeModeClient:
+      m_WifiClient.write(&frame[0], sizeof(frame));
+      break;
+    case probeModeInternal:
+      memcpy(&m_buffer[m_inPos], &frame[0], sizeof(frame));
+      m_inPos += sizeof(frame);
+      break;
+    default:
+      break;
+  }
+
+  m_probe.sentAt = millis();
+}
+
+void EspSerialBridge::probeReceive(byte data) {
+  if (m_probe.phase == probePhaseDrain)
+    return;
+
+  // sync to marker (second byte tells the phase, late latency frames are dropped during burst)
+  if ((m_probe.rxPos == 0 && data != 0xA5) || (m_probe.rxPos == 1 && data != 0x5A + m_probe.phase)) {
+    m_probe.rxPos = (data == 0xA5 ? 1 : 0);
+    return;
+  }
+
+  m_probe.rx[m_probe.rxPos++] = data;
+  if (m_probe.rxPos < m_probeFrameSize)
+    return;
+
+  m_probe.rxPos = 0;
+
+  uint16_t seq = (m_probe.rx[2] << 8) | m_probe.rx[3];
+  uint32_t sent = ((uint32_t)m_probe.rx[4] << 24) | ((uint32_t)m_probe.rx[5] << 16) | ((uint32_t)m_probe.rx[6] << 8) | m_probe.rx[7];
+
+  if (m_probe.phase == probePhaseBurst) {
+    // in order, gaps are lost frames
+    if (seq < m_probe.seq || seq >= m_probe.burstSent)
+      return;
+
+    m_probe.seq = seq + 1;
+    m_probe.burstReceived++;
+    m_probe.burstEnd = micros();
+    m_probe.sentAt = millis();
+    return;
+  }
+
+  // late or foreign frame
+  if (!m_probe.pending || seq != m_probe.seq)
+    return;
+
+  m_probe.rtt[m_probe.received++] = micros() - sent;
+  m_probe.seq++;
+  m_probe.pending = false;
+  m_probe.sentAt = millis();
+}
+
+void EspSerialBridge::probeFinish() {
+  ProbeResult *result = &m_probeResults[m_probe.mode - 1];
+
+  // outstanding frame (probe stopped) counts as lost
+  if (m_probe.pending) {
+    m_probe.lost++;
+    m_probe.pending = false;
+  }
+
+  // sort for median/p99
+  for (uint16_t i=1; i<m_probe.received; i++) {
+    uint32_t rtt = m_probe.rtt[i];
+    uint16_t j = i;
+    for (; j>0 && m_probe.rtt[j - 1] > rtt; j--)
+      m_probe.rtt[j] = m_probe.rtt[j - 1];
+    m_probe.rtt[j] = rtt;
+  }
+
+  result->valid = true;
+  result->samples = m_probe.received;
+  result->lost = m_probe.lost;
+  result->min = result->median = result->p99 = 0;
+  if (m_probe.received > 0) {
+    // nearest rank
+    result->min = m_probe.rtt[0];
+    result->median = m_probe.rtt[(m_probe.received - 1) / 2];
+    result->p99 = m_probe.rtt[(m_probe.received * 99 + 99) / 100 - 1];
+  }
+
+  // echoed bytes from first send to last echo
+  unsigned long elapsed = m_probe.burstEnd - m_probe.burstStart;
+  result->burstSent = m_probe.burstSent;
+  result->burstReceived = m_probe.burstReceived;
+  result->throughput = (elapsed > 0 ? (uint32_t)((uint64_t)m_probe.burstReceived * m_probeFrameSize * 1000000 / elapsed) : 0);
+
+  m_inPos = 0;
+
+  // echoes still on their way are dropped by probeLoop for another timeout
+  if (m_probe.lost > 0 || m_probe.burstReceived < m_probe.burstSent) {
+    m_probe.phase = probePhaseDrain;
+    m_probe.sentAt = millis();
+  } else
+    m_probe.mode = probeModeNone;
+}
+
+void EspSerialBridge::printProbe(Print& dest) {
+  const char *modes[] = { "none", "serial", "client", "internal" };
+  bool results = false;
+
+  if (m_probe.mode != probeModeNone && m_probe.phase == probePhaseDrain)
+    dest.printf("probe: %s draining\n", modes[m_probe.mode]);
+  else if (m_probe.mode != probeModeNone)
+    dest.printf("probe: %s running %d/%d burst %d/%d\n", modes[m_probe.mode], m_probe.received, m_probe.count
+      , m_probe.burstReceived, m_probeBurstFrames);
+
+  for (uint8_t i=0; i<probeModeInternal; i++) {
+    ProbeResult *result = &m_probeResults[i];
+    if (!result->valid)
+      continue;
+
+    results = true;
+    dest.printf("probe: %s samples %d lost %d min %luus median %luus p99 %luus burst %d/%d %lu B/s\n", modes[i + 1]
+      , result->samples, result->lost, (unsigned long)result->min, (unsigned long)result->median, (unsigned long)result->p99
+      , result->burstReceived, result->burstSent, (unsigned long)result->throughput);
+  }
+
+  if (!results && m_probe.mode == probeModeNone)
+    dest.printf("probe: no results\n");
+}
+
 #ifdef _ESPSERIALBRIDGE_TELNET_SUPPORT
 
 void enableSessionDetection(bool enable=true) {
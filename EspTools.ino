@@ -45,6 +45,10 @@ void loopEspTools() {
     espToolsUptimeDays++;
     espToolsLastMillis += 86400000;
   }
+
+#ifdef _DEBUG_HEAP
+  loopHeapStats();
+#endif
 }
 
 String uptime() {
@@ -65,3 +69,137 @@ String uptime() {
 
   return result;
 }
+
+#ifdef _DEBUG_HEAP
+// free heap watermark (every loop) and sampled history (loopEspTools): 5 min samples
+// for the last hour, hourly/daily entries keep the worst 5 min sample of their interval
+const unsigned long heapSampleInterval = 300000;  // 5 min
+
+struct HeapSample {
+  uint32_t  free;
+  uint32_t  maxBlock;
+  uint8_t   frag;
+};
+
+struct HeapHistory {
+  const char  *name;
+  HeapSample  *samples;
+  uint8_t     size, pos, cnt;
+  uint16_t    every;      // 5 min samples per entry
+  uint16_t    folded;
+  HeapSample  worst;
+};
+
+HeapSample heapHistory5min[12], heapHistoryHour[24], heapHistoryDay[28];
+HeapHistory heapHistories[] = {
+  { "5min", heapHistory5min, 12, 0, 0, 1 }      // 1 hour
+, { "hour", heapHistoryHour, 24, 0, 0, 12 }     // 1 day
+, { "day",  heapHistoryDay,  28, 0, 0, 288 }    // 4 weeks
+};
+const uint8_t heapHistoryCount = sizeof(heapHistories) / sizeof(heapHistories[0]);
+
+uint32_t heapMinFree = 0xFFFFFFFF;
+uint32_t heapSampledMinMaxBlock = 0xFFFFFFFF;
+uint8_t heapSampledMaxFrag = 0;
+unsigned long heapLastSample = 0;
+bool heapSampled = false;
+
+// loop() calls per subsystem that returned with less free heap than they started,
+// not an allocation count (lwIP buffers count, freed temporaries don't), see test/host
+uint32_t heapProbeFree = 0;
+uint32_t heapDropCount[heapSubsystemCount] = { 0 };
+const char *heapSubsystemNames[heapSubsystemCount] = { "wifi", "tools", "bridge", "debug" };
+
+uint32_t heapMaxFreeBlock() {
+#ifdef ESP8266
+  return ESP.getMaxFreeBlockSize();
+#endif
+#ifdef ESP32
+  return ESP.getMaxAllocHeap();
+#endif
+}
+
+uint8_t heapFragmentation() {
+#ifdef ESP8266
+  return ESP.getHeapFragmentation();
+#endif
+#ifdef ESP32
+  uint32_t free = ESP.getFreeHeap();
+  return (free == 0 ? 0 : 100 - (heapMaxFreeBlock() * 100) / free);
+#endif
+}
+
+void heapProbeBegin() {
+  heapProbeFree = ESP.getFreeHeap();
+}
+
+void heapProbeEnd(uint8_t subsystem) {
+  uint32_t free = ESP.getFreeHeap();
+
+  if (free < heapMinFree)
+    heapMinFree = free;
+  if (free < heapProbeFree && subsystem < heapSubsystemCount)
+    heapDropCount[subsystem]++;
+}
+
+void heapSample() {
+  HeapSample sample = { ESP.getFreeHeap(), heapMaxFreeBlock(), heapFragmentation() };
+
+  if (sample.free < heapMinFree)
+    heapMinFree = sample.free;
+  if (sample.maxBlock < heapSampledMinMaxBlock)
+    heapSampledMinMaxBlock = sample.maxBlock;
+  if (sample.frag > heapSampledMaxFrag)
+    heapSampledMaxFrag = sample.frag;
+
+  for (uint8_t i=0; i<heapHistoryCount; i++) {
+    HeapHistory *history = &heapHistories[i];
+
+    if (history->folded == 0 || sample.free < history->worst.free)
+      history->worst.free = sample.free;
+    if (history->folded == 0 || sample.maxBlock < history->worst.maxBlock)
+      history->worst.maxBlock = sample.maxBlock;
+    if (history->folded == 0 || sample.frag > history->worst.frag)
+      history->worst.frag = sample.frag;
+
+    if (++history->folded < history->every)
+      continue;
+
+    history->samples[history->pos] = history->worst;
+    history->pos = (history->pos + 1) % history->size;
+    if (history->cnt < history->size)
+      history->cnt++;
+    history->folded = 0;
+  }
+}
+
+void loopHeapStats() {
+  if (heapSampled && millis() - heapLastSample < heapSampleInterval)
+    return;
+
+  heapSampled = true;
+  heapLastSample = millis();
+  heapSample();
+}
+
+void printHeapStats(Print& dest) {
+  dest.printf("heap: free %lu max block %lu frag %u%%\n", (unsigned long)ESP.getFreeHeap(), (unsigned long)heapMaxFreeBlock(), heapFragmentation());
+  dest.printf("heap: min free %lu\n", (unsigned long)heapMinFree);
+  dest.printf("heap: sampled min max block %lu max frag %u%%\n", (unsigned long)heapSampledMinMaxBlock, heapSampledMaxFrag);
+
+  // histories (oldest first, age in entries)
+  for (uint8_t h=0; h<heapHistoryCount; h++) {
+    HeapHistory *history = &heapHistories[h];
+
+    for (uint8_t i=0; i<history->cnt; i++) {
+      HeapSample *sample = &history->samples[(history->pos + history->size - history->cnt + i) % history->size];
+      dest.printf("heap: %s -%u free %lu max block %lu frag %u%%\n", history->name, history->cnt - i - 1
+        , (unsigned long)sample->free, (unsigned long)sample->maxBlock, sample->frag);
+    }
+  }
+
+  // heap drops per subsystem
+  for (uint8_t i=0; i<heapSubsystemCount; i++)
+    dest.printf("heap: %s drops %lu\n", heapSubsystemNames[i], (unsigned long)heapDropCount[i]);
+}
+#endif  // _DEBUG_HEAP
@@ -0,0 +1,178 @@
+// host stub of the Arduino/ESP8266 core, just enough to compile
+// EspDebug.ino and EspSerialBridgeImpl.ino with g++
+#ifndef _HOST_ARDUINO_H
+#define _HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HEX 16
+#define DEC 10
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// time is driven by the test
+extern unsigned long hostMicros;
+inline unsigned long micros() { return hostMicros; }
+inline unsigned long millis() { return hostMicros / 1000; }
+inline void delay(unsigned long) { }
+inline void delayMicroseconds(unsigned int) { }
+
+// String (heap backed like the core one, so temporaries show up as allocations)
+class String {
+  public:
+    String(const char *str="") { copy(str, strlen(str)); }
+    String(const String &str) { copy(str.c_str(), str.length()); }
+    String(int value, unsigned char base=DEC) { number(value, base); }
+    String(unsigned int value, unsigned char base=DEC) { number(value, base); }
+    String(long value, unsigned char base=DEC) { number(value, base); }
+    String(unsigned long value, unsigned char base=DEC) { number(value, base); }
+    String(unsigned char value, unsigned char base=DEC) { number(value, base); }
+    ~String() { free(m_buffer); }
+
+    String& operator=(const String &rhs) { if (this != &rhs) { free(m_buffer); copy(rhs.c_str(), rhs.length()); } return *this; }
+    String& operator+=(const String &rhs) { append(rhs.c_str(), rhs.length()); return *this; }
+    String& operator+=(const char *rhs) { append(rhs, strlen(rhs)); return *this; }
+    friend String operator+(const String &lhs, const String &rhs) { String result(lhs); result += rhs; return result; }
+    friend String operator+(const char *lhs, const String &rhs) { String result(lhs); result += rhs; return result; }
+
+    bool operator==(const char *rhs) const { return strcmp(c_str(), rhs) == 0; }
+    bool operator!=(const char *rhs) const { return !(*this == rhs); }
+    bool operator==(const String &rhs) const { return *this == rhs.c_str(); }
+    bool operator!=(const String &rhs) const { return !(*this == rhs.c_str()); }
+
+    const char *c_str() const { return m_buffer; }
+    unsigned int length() const { return m_len; }
+    long toInt() const { return atol(m_buffer); }
+
+  private:
+    void copy(const char *str, size_t len) {
+      m_buffer = (char*)malloc(len + 1);
+      memcpy(m_buffer, str, len);
+      m_buffer[len] = 0;
+      m_len = len;
+    }
+    void append(const char *str, size_t len) {
+      m_buffer = (char*)realloc(m_buffer, m_len + len + 1);
+      memcpy(&m_buffer[m_len], str, len);
+      m_len += len;
+      m_buffer[m_len] = 0;
+    }
+    void number(unsigned long value, unsigned char base) {
+      char buf[34];
+      snprintf(buf, sizeof(buf), (base == HEX ? "%lx" : "%lu"), value);
+      copy(buf, strlen(buf));
+    }
+
+    char *m_buffer;
+    size_t m_len;
+};
+
+class Print {
+  public:
+    virtual ~Print() { }
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size) {
+      size_t n = 0;
+      while (size--)
+        n += write(*buffer++);
+      return n;
+    }
+    size_t write(const char *str) { return write((const uint8_t*)str, strlen(str)); }
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+
+    size_t print(const char *str) { return write(str); }
+    size_t print(const String &str) { return write(str.c_str()); }
+    size_t println() { return write("\r\n"); }
+    size_t println(const char *str) { return print(str) + println(); }
+    size_t println(const String &str) { return print(str) + println(); }
+
+    // like the core: stack buffer, heap only for long output
+    size_t printf(const char *format, ...) __attribute__ ((format (printf, 2, 3))) {
+      va_list arg;
+      char temp[64];
+      char *buffer = temp;
+
+      va_start(arg, format);
+      size_t len = vsnprintf(temp, sizeof(temp), format, arg);
+      va_end(arg);
+      if (len > sizeof(temp) - 1) {
+        buffer = new char[len + 1];
+        va_start(arg, format);
+        vsnprintf(buffer, len + 1, format, arg);
+        va_end(arg);
+      }
+      len = write((const uint8_t*)buffer, len);
+      if (buffer != temp)
+        delete[] buffer;
+      return len;
+    }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() = 0;
+};
+
+// uart
+#define UART_NB_BIT_MASK      0B00001100
+#define UART_NB_BIT_5         0B00000000
+#define UART_NB_BIT_6         0B00000100
+#define UART_NB_BIT_7         0B00001000
+#define UART_NB_BIT_8         0B00001100
+
+#define UART_PARITY_MASK      0B00000011
+#define UART_PARITY_NONE      0B00000000
+#define UART_PARITY_EVEN      0B00000010
+#define UART_PARITY_ODD       0B00000011
+
+#define UART_NB_STOP_BIT_MASK 0B00110000
+#define UART_NB_STOP_BIT_0    0B00000000
+#define UART_NB_STOP_BIT_1    0B00010000
+#define UART_NB_STOP_BIT_15   0B00100000
+#define UART_NB_STOP_BIT_2    0B00110000
+
+enum SerialConfig {
+  SERIAL_8N1 = UART_NB_BIT_8 | UART_PARITY_NONE | UART_NB_STOP_BIT_1
+};
+
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long, SerialConfig) { }
+    void pins(uint8_t, uint8_t) { }
+    bool isTxEnabled() { return true; }
+    bool isRxEnabled() { return true; }
+
+    int available() override { return m_rxLen - m_rxPos; }
+    int read() override { return (m_rxPos < m_rxLen ? m_rx[m_rxPos++] : -1); }
+    int peek() override { return (m_rxPos < m_rxLen ? m_rx[m_rxPos] : -1); }
+    void flush() override { }
+    int availableForWrite() { return sizeof(m_tx) - m_txLen; }
+
+    size_t write(uint8_t data) override { return write(&data, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+    // test side
+    bool loopback = false;  // TX-RX jumper
+    size_t txTotal = 0;
+    void hostReceive(const uint8_t *buffer, size_t size);
+    size_t hostDrain();     // empties tx fifo, returns bytes
+
+  private:
+    uint8_t m_rx[256], m_tx[128];
+    size_t m_rxLen = 0, m_rxPos = 0, m_txLen = 0;
+};
+
+extern HardwareSerial Serial;
+
+#endif  // _HOST_ARDUINO_H
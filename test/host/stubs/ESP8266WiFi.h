@@ -0,0 +1,2 @@
+#include "WiFiClient.h"
+#include "WiFiServer.h"
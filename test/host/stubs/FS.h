@@ -0,0 +1 @@
+// host stub, file system is not used by the loops under test
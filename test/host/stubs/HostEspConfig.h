@@ -0,0 +1,23 @@
+// replaces EspConfig.h/EspWifi.h (build defines their include guards),
+// device config is only read by begin(uint16_t)
+#ifndef _HOST_ESPCONFIG_H
+#define _HOST_ESPCONFIG_H
+
+#include <Arduino.h>
+
+class EspDeviceConfig {
+  public:
+    String getValue(String) { return String(); }
+    void setValue(String, String) { }
+    bool hasChanged() { return false; }
+    bool saveToFile() { return true; }
+};
+
+class EspConfig {
+  public:
+    EspDeviceConfig getDeviceConfig(String) { return EspDeviceConfig(); }
+};
+
+extern EspConfig espConfig;
+
+#endif  // _HOST_ESPCONFIG_H
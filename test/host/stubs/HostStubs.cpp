@@ -0,0 +1,102 @@
+#include <Arduino.h>
+#include <WiFiServer.h>
+
+unsigned long hostMicros = 0;
+HardwareSerial Serial;
+
+// HardwareSerial
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+  size_t n = (size > sizeof(m_tx) - m_txLen ? sizeof(m_tx) - m_txLen : size);
+  memcpy(&m_tx[m_txLen], buffer, n);
+  m_txLen += n;
+  txTotal += n;
+  return n;
+}
+
+void HardwareSerial::hostReceive(const uint8_t *buffer, size_t size) {
+  if (m_rxPos == m_rxLen)
+    m_rxPos = m_rxLen = 0;
+  if (size > sizeof(m_rx) - m_rxLen)
+    size = sizeof(m_rx) - m_rxLen;
+  memcpy(&m_rx[m_rxLen], buffer, size);
+  m_rxLen += size;
+}
+
+size_t HardwareSerial::hostDrain() {
+  size_t n = m_txLen;
+  if (loopback)
+    hostReceive(m_tx, m_txLen);
+  m_txLen = 0;
+  return n;
+}
+
+// WiFiClient
+void HostClientContext::receive(const uint8_t *buffer, size_t size) {
+  if (rxPos == rxLen)
+    rxPos = rxLen = 0;
+  if (size > sizeof(rx) - rxLen)
+    size = sizeof(rx) - rxLen;
+  memcpy(&rx[rxLen], buffer, size);
+  rxLen += size;
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size) {
+  size_t n = available();
+  if (n > size)
+    n = size;
+  memcpy(buffer, &m_ctx->rx[m_ctx->rxPos], n);
+  m_ctx->rxPos += n;
+  return n;
+}
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size) {
+  if (status() != ESTABLISHED)
+    return 0;
+  if (size > m_ctx->window)
+    size = m_ctx->window;
+
+  for (size_t i=0; i<size && m_ctx->echo; i++) {
+    size_t offset = m_ctx->txTotal + i;
+    if ((offset >= m_ctx->drop[0][0] && offset < m_ctx->drop[0][1]) || (offset >= m_ctx->drop[1][0] && offset < m_ctx->drop[1][1]))
+      continue;
+    if (!m_ctx->hold)
+      m_ctx->receive(&buffer[i], 1);
+    else if (m_ctx->heldLen < sizeof(m_ctx->held))
+      m_ctx->held[m_ctx->heldLen++] = buffer[i];
+  }
+
+  m_ctx->txTotal += size;
+  return size;
+}
+
+// WiFiServer
+static struct {
+  uint16_t          port;
+  HostClientContext *ctx;
+} hostPending[4];
+
+void hostConnect(uint16_t port, HostClientContext *ctx) {
+  for (size_t i=0; i<sizeof(hostPending) / sizeof(hostPending[0]); i++)
+    if (hostPending[i].ctx == NULL) {
+      hostPending[i].port = port;
+      hostPending[i].ctx = ctx;
+      return;
+    }
+}
+
+bool WiFiServer::hasClient() {
+  for (size_t i=0; i<sizeof(hostPending) / sizeof(hostPending[0]); i++)
+    if (hostPending[i].ctx != NULL && hostPending[i].port == m_port)
+      return m_status == LISTEN;
+  return false;
+}
+
+WiFiClient WiFiServer::available() {
+  for (size_t i=0; i<sizeof(hostPending) / sizeof(hostPending[0]); i++)
+    if (hostPending[i].ctx != NULL && hostPending[i].port == m_port) {
+      WiFiClient client(hostPending[i].ctx);
+      hostPending[i].ctx = NULL;
+      return client;
+    }
+  return WiFiClient();
+}
@@ -0,0 +1,57 @@
+#ifndef _HOST_WIFICLIENT_H
+#define _HOST_WIFICLIENT_H
+
+#include <Arduino.h>
+
+enum tcp_state {
+  CLOSED      = 0,
+  LISTEN      = 1,
+  ESTABLISHED = 4
+};
+
+class IPAddress {
+  public:
+    String toString() const { return String("127.0.0.1"); }
+};
+
+// connection state shared by all copies of a WiFiClient (ClientContext in the core)
+struct HostClientContext {
+  uint8_t   status = ESTABLISHED;
+  size_t    window = 1460;  // availableForWrite, 0 = peer stopped reading
+  bool      echo = false;   // peer echoes everything it receives
+  size_t    drop[2][2] = { { 0, 0 }, { 0, 0 } };  // echo not sent for tx offsets [from, to)
+  bool      hold = false;   // echo delayed until release()
+  uint8_t   rx[1024], held[1024];
+  size_t    rxLen = 0, rxPos = 0, heldLen = 0;
+  size_t    txTotal = 0;
+
+  void receive(const uint8_t *buffer, size_t size);
+  void release() { receive(held, heldLen); heldLen = 0; }
+};
+
+class WiFiClient : public Stream {
+  public:
+    WiFiClient(HostClientContext *ctx=NULL) : m_ctx(ctx) { }
+
+    uint8_t status() { return (m_ctx ? m_ctx->status : CLOSED); }
+    bool connected() { return status() == ESTABLISHED; }
+    void stop() { if (m_ctx) m_ctx->status = CLOSED; m_ctx = NULL; }
+    void setNoDelay(bool) { }
+    IPAddress remoteIP() { return IPAddress(); }
+
+    int available() override { return (m_ctx ? m_ctx->rxLen - m_ctx->rxPos : 0); }
+    int read() override { return (available() > 0 ? m_ctx->rx[m_ctx->rxPos++] : -1); }
+    int read(uint8_t *buffer, size_t size);
+    int peek() override { return (available() > 0 ? m_ctx->rx[m_ctx->rxPos] : -1); }
+    void flush() override { }
+    size_t availableForWrite() { return (status() == ESTABLISHED ? m_ctx->window : 0); }
+
+    size_t write(uint8_t data) override { return write(&data, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+  private:
+    HostClientContext *m_ctx;
+};
+
+#endif  // _HOST_WIFICLIENT_H
@@ -0,0 +1,25 @@
+#ifndef _HOST_WIFISERVER_H
+#define _HOST_WIFISERVER_H
+
+#include "WiFiClient.h"
+
+class WiFiServer {
+  public:
+    WiFiServer(uint16_t port) : m_port(port) { }
+
+    uint8_t status() { return m_status; }
+    void begin() { m_status = LISTEN; }
+    void stop() { m_status = CLOSED; }
+    void setNoDelay(bool) { }
+    bool hasClient();
+    WiFiClient available();
+
+  private:
+    uint16_t m_port;
+    uint8_t m_status = CLOSED;
+};
+
+// test side: next connection accepted on port
+void hostConnect(uint16_t port, HostClientContext *ctx);
+
+#endif  // _HOST_WIFISERVER_H
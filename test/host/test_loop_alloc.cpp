@@ -0,0 +1,212 @@
+// steady state of EspSerialBridge::loop() and EspDebug::loop() must not allocate (bridging
+// and latency probe), every malloc/realloc/calloc/new is counted per subsystem (linked with --wrap)
+#include <Arduino.h>
+#include <new>
+
+#include "../../EspSerialBridgeImpl.h"
+
+extern "C" {
+  void *__real_malloc(size_t size);
+  void *__real_realloc(void *ptr, size_t size);
+  void *__real_calloc(size_t nmemb, size_t size);
+}
+
+enum hostSubsystem { hostSubsystemNone, hostSubsystemSerialBridge, hostSubsystemDebug, hostSubsystemCount };
+
+const char *hostSubsystemNames[hostSubsystemCount] = { "none", "bridge", "debug" };
+unsigned long hostAllocCount[hostSubsystemCount] = { 0 };
+hostSubsystem hostCurrent = hostSubsystemNone;
+
+extern "C" void *__wrap_malloc(size_t size) {
+  hostAllocCount[hostCurrent]++;
+  return __real_malloc(size);
+}
+
+extern "C" void *__wrap_realloc(void *ptr, size_t size) {
+  hostAllocCount[hostCurrent]++;
+  return __real_realloc(ptr, size);
+}
+
+extern "C" void *__wrap_calloc(size_t nmemb, size_t size) {
+  hostAllocCount[hostCurrent]++;
+  return __real_calloc(nmemb, size);
+}
+
+void *operator new(size_t size) {
+  hostAllocCount[hostCurrent]++;
+  void *ptr = __real_malloc(size);
+  if (ptr == NULL)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void *operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete[](void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { free(ptr); }
+
+EspConfig espConfig;
+EspDebug espDebug;
+EspSerialBridge espSerialBridge;
+
+HostClientContext bridgeClient, debugClient;
+
+// collects printProbe output
+class HostPrint : public Print {
+  public:
+    size_t write(uint8_t data) override {
+      if (len + 1 < sizeof(buffer))
+        buffer[len++] = data;
+      buffer[len] = 0;
+      return 1;
+    }
+    char buffer[512] = { 0 };
+    size_t len = 0;
+};
+
+int result = 0;
+
+void expect(bool condition, const char *what) {
+  if (!condition) {
+    printf("FAIL: %s\n", what);
+    result = 1;
+  }
+}
+
+// report of printProbe contains text
+bool reportHas(const char *text, bool expected=true) {
+  HostPrint report;
+  espSerialBridge.printProbe(report);
+  bool found = (strstr(report.buffer, text) != NULL);
+
+  if (found != expected)
+    printf("%s \"%s\" in:\n%s", (expected ? "missing" : "unexpected"), text, report.buffer);
+  return found;
+}
+
+void probeLoop(hostSubsystem subsystem) {
+  hostCurrent = subsystem;
+  if (subsystem == hostSubsystemSerialBridge)
+    espSerialBridge.loop();
+  else
+    espDebug.loop();
+  hostCurrent = hostSubsystemNone;
+}
+
+// runs a probe until it ended (drain included), returns loops or -1; steps[] are us between
+// loops (an echo is collected one loop after its frame was sent), release of held echoes at loop
+int runProbe(EspSerialBridge::probeMode mode, uint16_t count, const unsigned long *steps=NULL, size_t stepCount=0
+  , int releaseAt=-1, int maxLoops=20000) {
+  if (!espSerialBridge.startProbe(mode, count))
+    return -1;
+
+  for (int i=0; i<maxLoops; i++) {
+    hostMicros += ((size_t)i < stepCount ? steps[i] : 1000);
+    if (i == releaseAt)
+      bridgeClient.release();
+    probeLoop(hostSubsystemSerialBridge);
+    Serial.hostDrain();
+    // keep bridging until held echoes were released
+    if (!espSerialBridge.isProbeRunning() && i >= releaseAt)
+      return i + 1;
+  }
+
+  return -1;
+}
+
+int main() {
+  const uint8_t serialData[] = "0123456789abcdef";
+  const uint8_t netData[] = "fedcba9876543210";
+  const unsigned int loops = 1000;
+
+  espSerialBridge.begin(9600, SERIAL_8N1, 23);
+  espDebug.begin(9001);
+
+  // connecting clients may allocate
+  hostConnect(23, &bridgeClient);
+  hostConnect(9001, &debugClient);
+  espSerialBridge.loop();
+  espDebug.loop();
+
+  for (int i=0; i<hostSubsystemCount; i++)
+    hostAllocCount[i] = 0;
+
+  // steady state: traffic in both directions, pending debug output
+  for (unsigned int i=0; i<loops; i++) {
+    hostMicros += 1000;
+    Serial.hostReceive(serialData, sizeof(serialData) - 1);
+    bridgeClient.receive(netData, sizeof(netData) - 1);
+    espDebug.write((const uint8_t*)"tick\n", 5);
+
+    probeLoop(hostSubsystemSerialBridge);
+    probeLoop(hostSubsystemDebug);
+    Serial.hostDrain();
+  }
+
+  // make sure data was actually bridged
+  expect(bridgeClient.txTotal >= loops * (sizeof(serialData) - 1) && Serial.txTotal >= loops * (sizeof(netData) - 1), "bridged data");
+  expect(debugClient.txTotal >= loops * 5, "debug output");
+
+  // probe every segment: TX-RX jumper, echoing client, internal
+  Serial.loopback = true;
+  bridgeClient.echo = true;
+  expect(runProbe(EspSerialBridge::probeModeSerial, 16) > 0, "serial probe");
+  expect(runProbe(EspSerialBridge::probeModeClient, 16) > 0, "client probe");
+  expect(espSerialBridge.startProbe(EspSerialBridge::probeModeInternal, 16), "internal probe started");
+  expect(!espSerialBridge.startProbe(EspSerialBridge::probeModeSerial, 16), "second probe refused while running");
+  for (int i=0; i<100 && espSerialBridge.isProbeRunning(); i++) {
+    hostMicros += 1000;
+    probeLoop(hostSubsystemSerialBridge);
+  }
+  expect(!espSerialBridge.isProbeRunning(), "internal probe ended");
+
+  expect(reportHas("probe: serial samples 16 lost 0 min 1000us median 1000us p99 1000us burst 32/32"), "serial result");
+  expect(reportHas("probe: client samples 16 lost 0 min 1000us median 1000us p99 1000us burst 32/32"), "client result");
+  expect(reportHas("probe: internal samples 16 lost 0 min 1000us median 1000us p99 1000us burst 32/32"), "internal result");
+  expect(!reportHas(" 0 B/s", false), "burst throughput");
+
+  // varied round trips 100..1600us: median is the 8th, p99 (nearest rank) the 16th of 16
+  unsigned long steps[17] = { 1000 };
+  for (int i=0; i<16; i++)
+    steps[i + 1] = ((i * 7) % 16 + 1) * 100;
+  expect(runProbe(EspSerialBridge::probeModeSerial, 16, steps, 17) > 0, "varied serial probe");
+  expect(reportHas("probe: serial samples 16 lost 0 min 100us median 800us p99 1600us burst 32/32"), "varied serial result");
+
+  // client drops latency frame 2 and burst frames 5/6 (burst starts after 8 latency frames)
+  bridgeClient.txTotal = 0;
+  bridgeClient.drop[0][0] = 2 * 8;  bridgeClient.drop[0][1] = 3 * 8;
+  bridgeClient.drop[1][0] = 13 * 8; bridgeClient.drop[1][1] = 15 * 8;
+  expect(runProbe(EspSerialBridge::probeModeClient, 8) > 0, "lossy client probe");
+  expect(reportHas("probe: client samples 7 lost 1"), "lossy client latency");
+  expect(reportHas("burst 30/32"), "lossy client burst");
+  bridgeClient.drop[0][1] = bridgeClient.drop[1][1] = 0;
+
+  // client stopped reading: probe gives up after the timeout and the drain (~2s), bridging resumes
+  bridgeClient.window = 0;
+  int stalled = runProbe(EspSerialBridge::probeModeClient, 8, NULL, 0, -1, 5000);
+  expect(stalled > 0, "stalled client probe ended");
+  expect(reportHas("probe: client samples 0 lost 8"), "stalled client result");
+  bridgeClient.window = 1460;
+
+  // echoes arriving after their timeout are dropped, nothing reaches the uart:
+  // 4 latency timeouts + burst timeout = ~5000 loops, released within the 1s drain
+  size_t serialTx = Serial.txTotal;
+  bridgeClient.hold = true;
+  expect(runProbe(EspSerialBridge::probeModeClient, 4, NULL, 0, 5500) > 0, "late client probe ended");
+  expect(reportHas("probe: client samples 0 lost 4 min 0us median 0us p99 0us burst 0/32"), "late client result");
+  expect(Serial.txTotal == serialTx, "late echoes not bridged to uart");
+  bridgeClient.hold = false;
+
+  for (int i=hostSubsystemSerialBridge; i<hostSubsystemCount; i++) {
+    printf("%s: %lu allocations in %u loops\n", hostSubsystemNames[i], hostAllocCount[i], loops);
+    if (hostAllocCount[i] > 0)
+      result = 1;
+  }
+
+  printf("%s\n", (result == 0 ? "PASS" : "FAIL"));
+  return result;
+}